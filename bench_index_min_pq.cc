@@ -0,0 +1,89 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_index_min_pq.h"
+#include "index_min_pq.h"
+
+// Number of indexes pushed, decreased, then popped in each run
+const unsigned int kNumItems = 1 << 20;
+
+// IndexMinPQ shared by all threads behind a single lock (current approach)
+class LockedIndexMinPQ {
+ public:
+  explicit LockedIndexMinPQ(size_t capacity) : pq(capacity) {}
+  void Push(double key, unsigned int idx) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pq.Push(key, idx);
+  }
+  bool DecreaseKey(double key, unsigned int idx) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pq.Contains(idx) || !(pq.GetKey(idx) > key))
+      return false;
+    pq.ChangeKey(key, idx);
+    return true;
+  }
+  bool TryPopMin(unsigned int &idx, double &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pq.Size())
+      return false;
+    idx = pq.Top();
+    key = pq.GetKey(idx);
+    pq.Pop();
+    return true;
+  }
+ private:
+  std::mutex mutex;
+  IndexMinPQ<double> pq;
+};
+
+// Run Push/DecreaseKey/TryPopMin over all indexes with @num_threads threads,
+// each working on its own share of indexes, and return millions of
+// operations per second
+template <typename PQ>
+double RunBenchmark(PQ &pq, unsigned int num_threads) {
+  auto worker = [&](unsigned int thread_id) {
+    std::minstd_rand gen(thread_id);
+    std::uniform_real_distribution<double> dist(0.0, 1000.0);
+    for (unsigned int idx = thread_id; idx < kNumItems; idx += num_threads)
+      pq.Push(dist(gen), idx);
+    for (unsigned int idx = thread_id; idx < kNumItems; idx += num_threads)
+      pq.DecreaseKey(dist(gen), idx);
+    unsigned int idx;
+    double key;
+    while (pq.TryPopMin(idx, key)) {}
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < num_threads; i++)
+    threads.push_back(std::thread(worker, i));
+  for (auto &thread : threads)
+    thread.join();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return 3.0 * kNumItems / elapsed.count() / 1e6;
+}
+
+int main() {
+  std::cout << "threads  locked heap (Mops/s)  multiqueue (Mops/s)"
+            << std::endl;
+  for (unsigned int num_threads = 1; num_threads <= 64; num_threads *= 2) {
+    LockedIndexMinPQ locked(kNumItems);
+    double locked_rate = RunBenchmark(locked, num_threads);
+    ConcurrentIndexMinPQ<double> multi(kNumItems, 2 * num_threads);
+    double multi_rate = RunBenchmark(multi, num_threads);
+
+    std::cout << std::setw(7) << num_threads
+              << std::fixed << std::setprecision(2)
+              << std::setw(22) << locked_rate
+              << std::setw(21) << multi_rate << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+#ifndef CONCURRENT_INDEX_MIN_PQ_H_
+#define CONCURRENT_INDEX_MIN_PQ_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "index_min_pq.h"
+
+// Indexed min-priority queue that can be shared by several threads.
+//
+// It is a relaxed priority queue (MultiQueue): indexes are spread over
+// several sequential IndexMinPQ, each protected by its own lock, and
+// TryPopMin removes the smallest of the tops of two randomly chosen queues.
+// The popped index is thus one of the smallest ones, not necessarily the
+// smallest, in exchange for threads rarely contending on the same lock.
+template <typename K>
+class ConcurrentIndexMinPQ {
+ public:
+  // Constructor with max number of indexes and number of internal queues
+  // (a small multiple of the number of threads)
+  ConcurrentIndexMinPQ(size_t capacity, size_t num_queues);
+  // Return number of items
+  size_t Size();
+  // Associates @key with index @idx
+  void Push(const K &key, unsigned int idx);
+  // Lower key associated to index @idx to @key. Return false if @idx is not
+  // in the queue or if its key is already smaller or equal
+  bool DecreaseKey(const K &key, unsigned int idx);
+  // Remove one of the smallest items and store it in @idx and @key. Return
+  // false if the queue is empty
+  bool TryPopMin(unsigned int &idx, K &key);
+
+ private:
+  // Sequential queue and its lock
+  struct SubQueue {
+    explicit SubQueue(size_t capacity) : pq(capacity) {}
+    std::mutex mutex;
+    IndexMinPQ<K> pq;
+  };
+
+  // Private members
+  size_t capacity;
+  std::atomic<size_t> cur_size;
+  std::vector<std::unique_ptr<SubQueue>> queues;
+
+  // Helper methods for indices: each index always lives in the same queue
+  SubQueue &QueueOf(unsigned int idx) {
+    return *queues[idx % queues.size()];
+  }
+  unsigned int LocalIdx(unsigned int idx) {
+    return idx / queues.size();
+  }
+  unsigned int GlobalIdx(size_t queue, unsigned int local_idx) {
+    return local_idx * queues.size() + queue;
+  }
+
+  // Helper method returning a random queue number, from a per-thread
+  // generator
+  size_t RandomQueue() {
+    static thread_local std::minstd_rand gen(
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return gen() % queues.size();
+  }
+
+  // Helper method to pop the top of locked queue @i
+  void PopLocked(size_t i, unsigned int &idx, K &key) {
+    unsigned int local_idx = queues[i]->pq.Top();
+    key = queues[i]->pq.GetKey(local_idx);
+    idx = GlobalIdx(i, local_idx);
+    queues[i]->pq.Pop();
+    cur_size--;
+  }
+};
+
+template <typename K>
+ConcurrentIndexMinPQ<K>::ConcurrentIndexMinPQ(size_t capacity,
+                                              size_t num_queues)
+  : capacity(capacity),
+    cur_size(0) {
+      if (!num_queues)
+        throw std::invalid_argument("Number of queues invalid!");
+      for (size_t i = 0; i < num_queues; i++)
+        queues.emplace_back(
+            new SubQueue((capacity + num_queues - 1) / num_queues));
+    }
+
+template <typename K>
+size_t ConcurrentIndexMinPQ<K>::Size() {
+  return cur_size;
+}
+
+template <typename K>
+void ConcurrentIndexMinPQ<K>::Push(const K &key, unsigned int idx) {
+  if (idx >= capacity)
+    throw std::overflow_error("Index invalid!");
+
+  SubQueue &queue = QueueOf(idx);
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  queue.pq.Push(key, LocalIdx(idx));
+  cur_size++;
+}
+
+template <typename K>
+bool ConcurrentIndexMinPQ<K>::DecreaseKey(const K &key, unsigned int idx) {
+  if (idx >= capacity)
+    throw std::overflow_error("Index invalid!");
+
+  SubQueue &queue = QueueOf(idx);
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (!queue.pq.Contains(LocalIdx(idx)))
+    return false;
+  if (!(queue.pq.GetKey(LocalIdx(idx)) > key))
+    return false;
+  queue.pq.ChangeKey(key, LocalIdx(idx));
+  return true;
+}
+
+template <typename K>
+bool ConcurrentIndexMinPQ<K>::TryPopMin(unsigned int &idx, K &key) {
+  while (Size()) {
+    // 1. Lock two random queues, giving up on busy ones
+    size_t i = RandomQueue();
+    size_t j = RandomQueue();
+    std::unique_lock<std::mutex> lock_i(queues[i]->mutex, std::try_to_lock);
+    if (!lock_i.owns_lock())
+      continue;
+    std::unique_lock<std::mutex> lock_j;
+    if (j != i)
+      lock_j = std::unique_lock<std::mutex>(queues[j]->mutex,
+                                            std::try_to_lock);
+    if (!lock_j.owns_lock() || !queues[j]->pq.Size())
+      j = i;
+
+    // 2. Pop the smallest of both tops
+    IndexMinPQ<K> &pq_i = queues[i]->pq;
+    IndexMinPQ<K> &pq_j = queues[j]->pq;
+    if (pq_i.Size() && (!pq_j.Size() ||
+                        !(pq_i.GetKey(pq_i.Top()) > pq_j.GetKey(pq_j.Top())))) {
+      PopLocked(i, idx, key);
+      return true;
+    }
+    if (pq_j.Size()) {
+      PopLocked(j, idx, key);
+      return true;
+    }
+    lock_i.unlock();
+    if (lock_j.owns_lock())
+      lock_j.unlock();
+
+    // 3. Both were empty: with few items left, random picks may keep
+    // missing them, so scan every queue instead
+    for (size_t k = 0; k < queues.size(); k++) {
+      std::lock_guard<std::mutex> lock(queues[k]->mutex);
+      if (queues[k]->pq.Size()) {
+        PopLocked(k, idx, key);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+#endif  // CONCURRENT_INDEX_MIN_PQ_H_
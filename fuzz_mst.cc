@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "concurrent_index_min_pq.h"
+#include "index_min_pq.h"
+#include "mst.h"
+
+// Randomized differential testing of the mst engines and priority queues.
+// Every engine is checked against a reference Kruskal implementation, and
+// every priority queue against a reference std::set, on random inputs.
+//
+// Usage: ./fuzz_mst [iterations] [seed]
+
+// Random graph in the form of its list of edges
+struct RandomGraph {
+  unsigned int num_v;
+  std::vector<std::tuple<unsigned int, unsigned int, double>> edges;
+  // whether all weights are distinct, hence the mst unique
+  bool distinct;
+};
+
+// Throw a runtime_error describing a failed check
+void Fail(const std::string &what) {
+  throw std::runtime_error(what);
+}
+
+// Generate a random graph. Weights are multiples of 1/8 so that they are
+// printed and summed exactly, whatever the order of the sum.
+RandomGraph GenerateGraph(std::mt19937 &gen) {
+  RandomGraph graph;
+  graph.num_v = (gen() % 8) ? gen() % 60 : gen() % 400;
+  unsigned int num_e = graph.num_v ? gen() % (4 * graph.num_v + 1) : 0;
+
+  // distinct weights, a few repeated weights, or zero weights
+  unsigned int weight_mode = gen() % 3;
+  graph.distinct = (weight_mode == 0);
+  std::vector<unsigned int> weight_vec(num_e);
+  for (unsigned int i = 0; i < num_e; i++)
+    weight_vec[i] = (weight_mode == 0) ? i + 1 : gen() % (weight_mode * 3);
+  std::shuffle(weight_vec.begin(), weight_vec.end(), gen);
+
+  for (unsigned int i = 0; i < num_e; i++)
+    graph.edges.push_back(std::make_tuple(gen() % graph.num_v,
+                                          gen() % graph.num_v,
+                                          weight_vec[i] / 8.0));
+  return graph;
+}
+
+// Build a Graph the way prim_mst does, by parsing the graph file format
+Graph ToGraph(RandomGraph &random_graph) {
+  std::stringstream content;
+  content << std::setprecision(17) << random_graph.num_v << "\n";
+  for (auto &edge : random_graph.edges)
+    content << std::get<0>(edge) << " " << std::get<1>(edge) << " "
+            << std::get<2>(edge) << "\n";
+  return Graph(content);
+}
+
+// Reference mst: Kruskal's algorithm
+std::vector<Edge> ReferenceMst(RandomGraph &random_graph) {
+  std::vector<Edge> edges;
+  for (auto &edge : random_graph.edges)
+    edges.push_back(Edge(std::get<0>(edge), std::get<1>(edge),
+                         std::get<2>(edge)));
+  std::sort(edges.begin(), edges.end(), [](Edge &a, Edge &b) {
+    return EdgeKey(a) < EdgeKey(b);
+  });
+
+  UnionFind forest(random_graph.num_v);
+  std::vector<Edge> mst;
+  for (auto &edge : edges) {
+    if (forest.Union(edge.GetSrc(), edge.GetDst()))
+      mst.push_back(edge);
+  }
+  return mst;
+}
+
+// Total weight of a list of edges
+double TotalWeight(std::vector<Edge> &edges) {
+  double total_weight = 0.0;
+  for (auto &edge : edges)
+    total_weight += edge.GetWeight();
+  return total_weight;
+}
+
+// Check that @mst is a minimum spanning forest of the graph: it has as many
+// edges as the reference, all taken from the graph, without cycle, the same
+// weight, and every edge of it is a lightest edge across the cut it defines
+void CheckMst(RandomGraph &random_graph, std::vector<Edge> &mst,
+              std::vector<Edge> &reference) {
+  unsigned int num_v = random_graph.num_v;
+  if (mst.size() != reference.size())
+    Fail("wrong number of edges");
+  if (TotalWeight(mst) != TotalWeight(reference))
+    Fail("wrong total weight");
+
+  // Edges of the graph
+  std::multiset<std::tuple<unsigned int, unsigned int, double>> graph_edges;
+  for (auto &edge : random_graph.edges)
+    graph_edges.insert(std::make_tuple(
+        std::min(std::get<0>(edge), std::get<1>(edge)),
+        std::max(std::get<0>(edge), std::get<1>(edge)), std::get<2>(edge)));
+
+  UnionFind forest(num_v);
+  for (auto &edge : mst) {
+    EdgeKey key(edge);
+    auto itr = graph_edges.find(std::make_tuple(key.lo, key.hi, key.weight));
+    if (itr == graph_edges.end())
+      Fail("edge not in graph");
+    graph_edges.erase(itr);
+    if (!forest.Union(edge.GetSrc(), edge.GetDst()))
+      Fail("cycle in mst");
+  }
+
+  // Cut property: removing edge e splits its tree in two, and no edge of
+  // the graph joining both parts may be lighter than e
+  for (unsigned int i = 0; i < mst.size(); i++) {
+    UnionFind parts(num_v);
+    for (unsigned int j = 0; j < mst.size(); j++) {
+      if (j != i)
+        parts.Union(mst[j].GetSrc(), mst[j].GetDst());
+    }
+    for (auto &edge : random_graph.edges) {
+      unsigned int src = std::get<0>(edge);
+      unsigned int dst = std::get<1>(edge);
+      if (parts.Find(src) != parts.Find(dst) &&
+          std::get<2>(edge) < mst[i].GetWeight())
+        Fail("cut property violated");
+    }
+  }
+}
+
+// Run every mst engine on a random graph and check its result
+void FuzzEngines(std::mt19937 &gen, PrimWorkspace &workspace) {
+  RandomGraph random_graph = GenerateGraph(gen);
+  std::vector<Edge> reference = ReferenceMst(random_graph);
+  MstSummary reference_summary;
+  for (auto &edge : reference)
+    reference_summary.Add(edge);
+
+  // Sequential prim, reusing the workspace across graphs
+  Graph graph = ToGraph(random_graph);
+  std::vector<Edge> best_edge_vec = BuildPrimMst(graph, workspace);
+  std::vector<Edge> mst = MstEdgeList(best_edge_vec);
+  CheckMst(random_graph, mst, reference);
+
+  // Parallel prim
+  for (unsigned int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+    mst = BuildParallelPrimMst(graph, num_threads);
+    CheckMst(random_graph, mst, reference);
+    if (random_graph.distinct) {
+      MstSummary summary;
+      for (auto &edge : mst)
+        summary.Add(edge);
+      if (summary.hash != reference_summary.hash)
+        Fail("parallel prim: wrong edge set");
+    }
+  }
+
+  // Clustering into a random number of clusters: every component of the
+  // graph is a cluster, and with a unique mst the cut is unique too
+  unsigned int num_clusters = 1 + gen() % (random_graph.num_v + 2);
+  unsigned int num_components = random_graph.num_v - reference.size();
+  Clustering clustering = BuildClustering(random_graph.num_v,
+                                          MstEdgeList(best_edge_vec),
+                                          num_clusters);
+  Clustering reference_clustering = BuildClustering(random_graph.num_v,
+                                                    reference, num_clusters);
+  if (clustering.num_clusters != std::max(
+          std::min(num_clusters, random_graph.num_v), num_components))
+    Fail("clustering: wrong number of clusters");
+  if (clustering.dendrogram.size() != reference.size())
+    Fail("clustering: wrong number of merges");
+  if (random_graph.distinct &&
+      (clustering.cluster_vec != reference_clustering.cluster_vec ||
+       clustering.threshold != reference_clustering.threshold))
+    Fail("clustering: wrong clusters");
+
+  // Summary mode
+  MstSummary summary = BuildPrimSummary(graph, workspace);
+  if (summary.total_weight != reference_summary.total_weight ||
+      summary.num_edges != reference_summary.num_edges)
+    Fail("summary: wrong weight or number of edges");
+  if (random_graph.distinct && summary.hash != reference_summary.hash)
+    Fail("summary: wrong edge set");
+
+  // Parents mode: each parent link stands for the lightest edge between
+  // both vertices
+  std::vector<unsigned int> parent_vec = BuildPrimParents(graph, workspace);
+  std::map<std::pair<unsigned int, unsigned int>, double> lightest;
+  for (auto &edge : random_graph.edges) {
+    auto key = std::make_pair(std::min(std::get<0>(edge), std::get<1>(edge)),
+                              std::max(std::get<0>(edge), std::get<1>(edge)));
+    if (!lightest.count(key) || std::get<2>(edge) < lightest[key])
+      lightest[key] = std::get<2>(edge);
+  }
+  mst.clear();
+  for (unsigned int v = 0; v < parent_vec.size(); v++) {
+    unsigned int parent = parent_vec[v];
+    if (parent == v)
+      continue;
+    auto key = std::make_pair(std::min(v, parent), std::max(v, parent));
+    if (!lightest.count(key))
+      Fail("parents: link not in graph");
+    mst.push_back(Edge(v, parent, lightest[key]));
+  }
+  CheckMst(random_graph, mst, reference);
+}
+
+// Reference indexed priority queue
+class ReferencePQ {
+ public:
+  size_t Size() { return heap.size(); }
+  bool Contains(unsigned int idx) { return keys.count(idx) > 0; }
+  int MinKey() { return heap.begin()->first; }
+  int Key(unsigned int idx) { return keys[idx]; }
+  void Push(int key, unsigned int idx) {
+    keys[idx] = key;
+    heap.insert(std::make_pair(key, idx));
+  }
+  void Erase(unsigned int idx) {
+    heap.erase(std::make_pair(keys[idx], idx));
+    keys.erase(idx);
+  }
+ private:
+  std::map<unsigned int, int> keys;
+  std::set<std::pair<int, unsigned int>> heap;
+};
+
+// Run random operations on IndexMinPQ and compare with the reference. Keys
+// are drawn from a small range to exercise ties.
+void FuzzIndexMinPQ(std::mt19937 &gen) {
+  size_t capacity = 1 + gen() % 64;
+  IndexMinPQ<int> impq(capacity);
+  ReferencePQ reference;
+
+  for (unsigned int op = 0; op < 1000; op++) {
+    unsigned int idx = gen() % (capacity + 1);
+    int key = gen() % 10;
+    switch (gen() % 5) {
+      case 0:
+      case 1:
+        // Push
+        if (idx >= capacity || reference.Contains(idx)) {
+          bool thrown = false;
+          try { impq.Push(key, idx); } catch (std::exception &) {
+            thrown = true;
+          }
+          if (!thrown)
+            Fail("IndexMinPQ: Push did not throw");
+        } else {
+          impq.Push(key, idx);
+          reference.Push(key, idx);
+        }
+        break;
+      case 2:
+        // ChangeKey
+        if (idx < capacity && reference.Contains(idx)) {
+          impq.ChangeKey(key, idx);
+          reference.Erase(idx);
+          reference.Push(key, idx);
+        }
+        break;
+      case 3:
+        // Top and Pop
+        if (reference.Size()) {
+          unsigned int top = impq.Top();
+          if (!reference.Contains(top) ||
+              reference.Key(top) != reference.MinKey())
+            Fail("IndexMinPQ: Top is not minimum");
+          impq.Pop();
+          reference.Erase(top);
+        } else {
+          bool thrown = false;
+          try { impq.Pop(); } catch (std::exception &) { thrown = true; }
+          if (!thrown)
+            Fail("IndexMinPQ: Pop did not throw");
+        }
+        break;
+      case 4:
+        // Resize once emptied
+        if (!reference.Size() && gen() % 4 == 0) {
+          capacity = 1 + gen() % 64;
+          impq.Resize(capacity);
+        }
+        break;
+    }
+
+    // Both queues hold the same items
+    if (impq.Size() != reference.Size())
+      Fail("IndexMinPQ: wrong size");
+    for (unsigned int i = 0; i < capacity; i++) {
+      if (impq.Contains(i) != reference.Contains(i))
+        Fail("IndexMinPQ: wrong Contains");
+      if (reference.Contains(i) && impq.GetKey(i) != reference.Key(i))
+        Fail("IndexMinPQ: wrong key");
+    }
+  }
+}
+
+// Run random operations on ConcurrentIndexMinPQ from a single thread and
+// compare with the reference. With one internal queue it must pop the
+// minimum, with more any item may come out but with its current key.
+void FuzzConcurrentIndexMinPQ(std::mt19937 &gen) {
+  size_t capacity = 1 + gen() % 64;
+  size_t num_queues = 1 + gen() % 4;
+  ConcurrentIndexMinPQ<int> impq(capacity, num_queues);
+  ReferencePQ reference;
+
+  for (unsigned int op = 0; op < 1000; op++) {
+    unsigned int idx = gen() % capacity;
+    int key = gen() % 10;
+    switch (gen() % 3) {
+      case 0:
+        // Push
+        if (!reference.Contains(idx)) {
+          impq.Push(key, idx);
+          reference.Push(key, idx);
+        }
+        break;
+      case 1: {
+        // DecreaseKey
+        bool decreased = reference.Contains(idx) && key < reference.Key(idx);
+        if (impq.DecreaseKey(key, idx) != decreased)
+          Fail("ConcurrentIndexMinPQ: wrong DecreaseKey");
+        if (decreased) {
+          reference.Erase(idx);
+          reference.Push(key, idx);
+        }
+        break;
+      }
+      case 2: {
+        // TryPopMin
+        unsigned int popped;
+        int popped_key;
+        bool success = impq.TryPopMin(popped, popped_key);
+        if (success != (reference.Size() > 0))
+          Fail("ConcurrentIndexMinPQ: wrong TryPopMin");
+        if (!success)
+          break;
+        if (!reference.Contains(popped) ||
+            reference.Key(popped) != popped_key)
+          Fail("ConcurrentIndexMinPQ: popped item not in queue");
+        if (num_queues == 1 && popped_key != reference.MinKey())
+          Fail("ConcurrentIndexMinPQ: popped item is not minimum");
+        reference.Erase(popped);
+        break;
+      }
+    }
+    if (impq.Size() != reference.Size())
+      Fail("ConcurrentIndexMinPQ: wrong size");
+  }
+}
+
+// Run Push, DecreaseKey and TryPopMin on ConcurrentIndexMinPQ from several
+// threads at once (meant for the ThreadSanitizer build). Each thread pushes
+// and decreases its own indexes but pops any, and in the end every index
+// must have been popped once, with the last key it was decreased to.
+void FuzzConcurrentIndexMinPQThreads(std::mt19937 &gen) {
+  unsigned int num_threads = 2 + gen() % 7;
+  unsigned int capacity = num_threads * (1 + gen() % 200);
+  ConcurrentIndexMinPQ<int> impq(capacity, 1 + gen() % (2 * num_threads));
+
+  // Last key given to each index by its thread (disjoint per thread)
+  std::vector<int> last_key_vec(capacity);
+  // Items popped by each thread, and by the final drain
+  std::vector<std::vector<std::pair<unsigned int, int>>> popped(
+      num_threads + 1);
+
+  std::vector<unsigned int> seed_vec;
+  for (unsigned int t = 0; t < num_threads; t++)
+    seed_vec.push_back(gen());
+
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < num_threads; t++) {
+    threads.push_back(std::thread([&, t]() {
+      std::mt19937 thread_gen(seed_vec[t]);
+      // Indexes of this thread: t, t + num_threads, ...
+      unsigned int num_pushed = 0;
+      unsigned int num_own = capacity / num_threads;
+      for (unsigned int op = 0; op < 4 * num_own; op++) {
+        switch (thread_gen() % 3) {
+          case 0:
+            // Push
+            if (num_pushed < num_own) {
+              unsigned int idx = t + num_threads * num_pushed++;
+              last_key_vec[idx] = thread_gen() % 1000;
+              impq.Push(last_key_vec[idx], idx);
+            }
+            break;
+          case 1:
+            // DecreaseKey, which fails once the index has been popped
+            if (num_pushed) {
+              unsigned int idx = t + num_threads * (thread_gen() % num_pushed);
+              int key = last_key_vec[idx] - 1 - thread_gen() % 5;
+              if (impq.DecreaseKey(key, idx))
+                last_key_vec[idx] = key;
+            }
+            break;
+          case 2: {
+            // TryPopMin
+            unsigned int idx;
+            int key;
+            if (impq.TryPopMin(idx, key))
+              popped[t].push_back(std::make_pair(idx, key));
+            break;
+          }
+        }
+      }
+      // Push remaining indexes
+      while (num_pushed < num_own) {
+        unsigned int idx = t + num_threads * num_pushed++;
+        last_key_vec[idx] = thread_gen() % 1000;
+        impq.Push(last_key_vec[idx], idx);
+      }
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  unsigned int idx;
+  int key;
+  while (impq.TryPopMin(idx, key))
+    popped[num_threads].push_back(std::make_pair(idx, key));
+  if (impq.Size())
+    Fail("ConcurrentIndexMinPQ threads: queue not empty");
+
+  std::vector<bool> seen_vec(capacity, false);
+  for (auto &thread_popped : popped) {
+    for (auto &item : thread_popped) {
+      if (item.first >= capacity || seen_vec[item.first])
+        Fail("ConcurrentIndexMinPQ threads: index popped twice");
+      seen_vec[item.first] = true;
+      if (item.second != last_key_vec[item.first])
+        Fail("ConcurrentIndexMinPQ threads: popped with stale key");
+    }
+  }
+  if (std::count(seen_vec.begin(), seen_vec.end(), true) !=
+      static_cast<int>(capacity))
+    Fail("ConcurrentIndexMinPQ threads: index never popped");
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int num_iterations = (argc > 1) ? std::stoul(argv[1]) : 1000;
+  unsigned int seed = (argc > 2) ? std::stoul(argv[2]) : 1;
+
+  PrimWorkspace workspace;
+  for (unsigned int i = 0; i < num_iterations; i++) {
+    // Each iteration has its own seed so that failures can be replayed
+    std::mt19937 gen(seed + i);
+    try {
+      FuzzEngines(gen, workspace);
+      FuzzIndexMinPQ(gen);
+      FuzzConcurrentIndexMinPQ(gen);
+      FuzzConcurrentIndexMinPQThreads(gen);
+    } catch (std::exception &e) {
+      std::cerr << "Iteration " << i << " (seed " << seed + i << "): "
+                << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << num_iterations << " iterations passed" << std::endl;
+  return 0;
+}
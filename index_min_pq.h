@@ -11,10 +11,14 @@ class IndexMinPQ {
  public:
   // Constructor with max number of indexes
   explicit IndexMinPQ(size_t capacity);
+  // Change max number of indexes (queue must be empty)
+  void Resize(size_t capacity);
   // Return number of items
   size_t Size();
   // Return top (ie index associated to minimum key)
   unsigned int Top();
+  // Return key associated to index @idx
+  const K &GetKey(unsigned int idx);
   // Remove top
   void Pop();
   // Associates @key with index @idx
@@ -99,6 +103,18 @@ IndexMinPQ<K>::IndexMinPQ(size_t capacity)
       cur_size = 0;
     }
 
+template <typename K>
+void IndexMinPQ<K>::Resize(size_t capacity) {
+  if (Size())
+    throw std::runtime_error("Cannot resize non-empty priority queue!");
+
+  // reallocate storage only when growing, but always invalidate all indexes
+  this->capacity = capacity;
+  keys.resize(capacity);
+  heap_to_idx.resize(capacity + 1);
+  idx_to_heap.assign(capacity, 0);
+}
+
 template <typename K>
 size_t IndexMinPQ<K>::Size() {
   return cur_size;
@@ -113,6 +129,14 @@ unsigned int IndexMinPQ<K>::Top(void) {
   return heap_to_idx[Root()];
 }
 
+template <typename K>
+const K &IndexMinPQ<K>::GetKey(unsigned int idx) {
+  if (!Contains(idx))
+    throw std::runtime_error("Index does not exist!");
+
+  return keys[idx];
+}
+
 template <typename K>
 void IndexMinPQ<K>::PercolateUp(unsigned int i) {
   while (HasParent(i) && GreaterNode(Parent(i), i)) {
@@ -165,11 +189,15 @@ void IndexMinPQ<K>::Pop() {
     throw std::underflow_error("Empty priority queue!");
 
   // remove min item
-  // 3. Mark idx_to_heap mapping as invalid
-  idx_to_heap[heap_to_idx[Root()]] = 0;
+  unsigned int top_idx = heap_to_idx[Root()];
   // 1. Move last item back to root and reduce heap's size
+  //  - Update mapping of moved item, even if it stays at the root
   heap_to_idx[Root()] = heap_to_idx[cur_size--];
-  // 2. Restore heap order
+  idx_to_heap[heap_to_idx[Root()]] = Root();
+  // 2. Mark idx_to_heap mapping as invalid (after 1. in case the removed
+  // item was the last one)
+  idx_to_heap[top_idx] = 0;
+  // 3. Restore heap order
   PercolateDown(Root());
 }
 
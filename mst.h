@@ -0,0 +1,540 @@
+#ifndef MST_H_
+#define MST_H_
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "concurrent_index_min_pq.h"
+#include "index_min_pq.h"
+
+// Class of edge that stores source vertex, destination vertex, and
+// the weight of the edge
+class Edge {
+ public:
+  // Constructor
+  Edge(unsigned int src, unsigned int dst, double weight)
+                                        : src(src), dst(dst), weight(weight) {}
+  unsigned int GetSrc() { return src; }
+  unsigned int GetDst() { return dst; }
+  double GetWeight() { return weight; }
+ private:
+  unsigned int src;
+  unsigned int dst;
+  double weight;
+};
+
+// Class that represents graph. Adjacent_list implementation is used, but
+// instead of vector of vertex, we used vector of Edge for each vertex.
+class Graph {
+ public:
+  // Constructor
+  explicit Graph(std::istream &input_file);
+  // number of vertices
+  unsigned int GetNumV() { return num_vertex; }
+  // Vector of Edges adjacent to vertex
+  std::vector<std::vector<Edge>> &GetAdjEdgeVec() { return adj_edge_vec; }
+ private:
+  unsigned int num_vertex;
+  // Adjacency lists implementation
+  std::vector<std::vector<Edge>> adj_edge_vec;
+};
+
+inline Graph::Graph(std::istream &input_file) {
+  // Get number of vertices
+  input_file >> num_vertex;
+
+  // Allocate list of vertces
+  adj_edge_vec.resize(num_vertex);
+
+  unsigned int cur_src;
+  unsigned int cur_dst;
+  double cur_weight;
+
+  // Go through all the edges
+  while (input_file >> cur_src >> cur_dst >> cur_weight) {
+    Edge cur_edge(cur_src, cur_dst, cur_weight);
+    adj_edge_vec[cur_src].push_back(cur_edge);
+    adj_edge_vec[cur_dst].push_back(cur_edge);
+  }
+}
+
+// Scratch buffers of PrimTraverse, which can be kept across calls so that
+// solving many graphs in a row does not reallocate them every time
+struct PrimWorkspace {
+  PrimWorkspace() : Q(0) {}
+  // min-priority queue of vertices
+  IndexMinPQ<double> Q;
+  // distance from the tree to each vertex
+  std::vector<double> dist_vec;
+  // whether each vertex has been visited
+  std::vector<bool> marked_vec;
+  // vertex through which each vertex is best reached, roots being their
+  // own parent
+  std::vector<unsigned int> parent_vec;
+};
+
+// Run prim's algorithm on the graph, using @workspace as scratch space, and
+// call @visit(v, parent, weight) each time vertex v joins the tree through
+// an mst edge of weight @weight to @parent (vertices starting a new tree
+// are not visited). The parent of every vertex is left in @workspace.
+template <typename Visitor>
+void PrimTraverse(Graph &graph, PrimWorkspace &workspace, Visitor visit) {
+  // store graph's objects as local variables
+  unsigned int num_v = graph.GetNumV();
+  std::vector<std::vector<Edge>> &adj_edge_vec = graph.GetAdjEdgeVec();
+
+  // min-priority queue Q, emptied by the previous run
+  IndexMinPQ<double> &Q = workspace.Q;
+  Q.Resize(num_v);
+  // Unknown distance from src to v
+  std::vector<double> &dist_vec = workspace.dist_vec;
+  dist_vec.assign(num_v, INFINITY);
+  // Vertex v has not been visited
+  std::vector<bool> &marked_vec = workspace.marked_vec;
+  marked_vec.assign(num_v, false);
+  // Parent of v through best edge to v
+  std::vector<unsigned int> &parent_vec = workspace.parent_vec;
+  parent_vec.assign(num_v, 0);
+
+  // Go through each vertex in graph
+  for (unsigned int v = 0; v < num_v; v++) {
+    // Skip visited vertex
+    if (marked_vec[v]) {
+      continue;
+    }
+
+    // Distance from v to itself is 0
+    dist_vec[v] = 0;
+    parent_vec[v] = v;
+
+    // Add first vertex to queue
+    Q.Push(dist_vec[v], v);
+
+    // iterate until min Q becomes empty
+    while (Q.Size()) {
+      // Remove and return closest vertex
+      unsigned int root = Q.Top();
+      Q.Pop();
+
+      // We have reached root
+      marked_vec[root] = true;
+      if (parent_vec[root] != root)
+        visit(root, parent_vec[root], dist_vec[root]);
+
+      // Go through all the neighbors
+      for (auto &adj_edge : adj_edge_vec[root]) {
+        // vertex adjacent to root
+        unsigned int adj;
+
+        // find the adj vertex from the adj edge: (root - adj) or (adj - root)
+        if (adj_edge.GetDst() == root)
+          adj = adj_edge.GetSrc();
+        else
+          adj = adj_edge.GetDst();
+
+        // Skip visited vertex
+        if (marked_vec[adj]) {
+          continue;
+        }
+
+        // New path to reach vertex is better than existing one
+        if (adj_edge.GetWeight() < dist_vec[adj]) {
+          dist_vec[adj] = adj_edge.GetWeight();         // Update distance to v
+          parent_vec[adj] = root;                      // Update best edge to v
+
+          // Update priority queue
+          if (Q.Contains(adj))
+            Q.ChangeKey(dist_vec[adj], adj);
+          else
+            Q.Push(dist_vec[adj], adj);
+        }
+      }
+    }
+  }
+}
+
+// Build prim mst from the graph, using @workspace as scratch space
+inline std::vector<Edge> BuildPrimMst(Graph &graph,
+                                      PrimWorkspace &workspace) {
+  std::vector<std::vector<Edge>> &adj_edge_vec = graph.GetAdjEdgeVec();
+  // Best edge to v
+  std::vector<Edge> best_edge_vec(graph.GetNumV(), Edge(0, 0, 0));
+  PrimTraverse(graph, workspace,
+               [&](unsigned int v, unsigned int parent, double weight) {
+    // Recover the edge as given in the graph: the first one between both
+    // vertices with that weight, as relaxation only keeps strictly lighter
+    // edges
+    for (auto &adj_edge : adj_edge_vec[v]) {
+      if ((adj_edge.GetSrc() == parent || adj_edge.GetDst() == parent) &&
+          adj_edge.GetWeight() == weight) {
+        best_edge_vec[v] = adj_edge;
+        break;
+      }
+    }
+  });
+
+  // mst is complete in the form of vector of edges
+  return best_edge_vec;
+}
+
+// Build prim mst from the graph
+inline std::vector<Edge> BuildPrimMst(Graph &graph) {
+  PrimWorkspace workspace;
+  return BuildPrimMst(graph, workspace);
+}
+
+// Build prim mst from the graph in the form of the parent of each vertex,
+// roots being their own parent. The array is taken over from @workspace,
+// so that the mst only costs 4 bytes per vertex.
+inline std::vector<unsigned int> BuildPrimParents(Graph &graph,
+                                                  PrimWorkspace &workspace) {
+  PrimTraverse(graph, workspace,
+               [](unsigned int v, unsigned int parent, double weight) {});
+  return std::move(workspace.parent_vec);
+}
+
+// Total weight, number of edges and hash of the edge set of an mst, which
+// can be accumulated one edge at a time. The hash does not depend on the
+// order nor on the orientation of edges, so that msts built by different
+// engines can be compared (as long as edge weights are distinct, otherwise
+// several msts may exist).
+struct MstSummary {
+  MstSummary() : total_weight(0.0), num_edges(0), hash(0) {}
+  // Add @edge to the summary
+  void Add(Edge &edge) {
+    double weight = edge.GetWeight();
+    uint64_t weight_bits;
+    std::memcpy(&weight_bits, &weight, sizeof(weight_bits));
+    uint64_t lo = std::min(edge.GetSrc(), edge.GetDst());
+    uint64_t hi = std::max(edge.GetSrc(), edge.GetDst());
+
+    total_weight += weight;
+    num_edges++;
+    hash += Mix(Mix((lo << 32) | hi) ^ weight_bits);
+  }
+  double total_weight;
+  uint64_t num_edges;
+  uint64_t hash;
+
+ private:
+  // splitmix64 finalizer
+  static uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+};
+
+// Summarize prim mst of the graph without storing its edges
+inline MstSummary BuildPrimSummary(Graph &graph,
+                                   PrimWorkspace &workspace) {
+  MstSummary summary;
+  PrimTraverse(graph, workspace,
+               [&](unsigned int v, unsigned int parent, double weight) {
+    Edge edge(v, parent, weight);
+    summary.Add(edge);
+  });
+  return summary;
+}
+
+// Disjoint sets of vertices (union by size, path halving)
+class UnionFind {
+ public:
+  // Constructor with @n singletons
+  explicit UnionFind(unsigned int n) : parent_vec(n), size_vec(n, 1) {
+    for (unsigned int v = 0; v < n; v++)
+      parent_vec[v] = v;
+  }
+  // Return representative of the set of @v
+  unsigned int Find(unsigned int v) {
+    while (parent_vec[v] != v) {
+      parent_vec[v] = parent_vec[parent_vec[v]];
+      v = parent_vec[v];
+    }
+    return v;
+  }
+  // Merge sets of @u and @v, return false if they were already the same
+  bool Union(unsigned int u, unsigned int v) {
+    u = Find(u);
+    v = Find(v);
+    if (u == v)
+      return false;
+    if (size_vec[u] < size_vec[v])
+      std::swap(u, v);
+    parent_vec[v] = u;
+    size_vec[u] += size_vec[v];
+    return true;
+  }
+ private:
+  std::vector<unsigned int> parent_vec;
+  std::vector<unsigned int> size_vec;
+};
+
+// Key ordering edges by weight, then by endpoints. All edges being distinct
+// under this order, the mst is unique, so that edges picked independently by
+// several threads all belong to the same tree.
+struct EdgeKey {
+  EdgeKey() : weight(INFINITY), lo(UINT_MAX), hi(UINT_MAX) {}
+  explicit EdgeKey(Edge &edge)
+    : weight(edge.GetWeight()),
+      lo(std::min(edge.GetSrc(), edge.GetDst())),
+      hi(std::max(edge.GetSrc(), edge.GetDst())) {}
+  bool operator<(const EdgeKey &other) const {
+    if (weight != other.weight)
+      return weight < other.weight;
+    if (lo != other.lo)
+      return lo < other.lo;
+    return hi < other.hi;
+  }
+  bool operator>(const EdgeKey &other) const {
+    return other < *this;
+  }
+  double weight;
+  unsigned int lo;
+  unsigned int hi;
+};
+
+// Build mst from the graph with @num_threads threads growing several prim
+// trees at once.
+//
+// Seed vertices are handed out by a shared ConcurrentIndexMinPQ, lightest
+// incident edge first. Each thread grows a tree from its seed with its own
+// heap, claiming vertices atomically, until the lightest edge leaving
+// its tree reaches a vertex claimed by another tree; that edge is kept and
+// the thread moves on to another seed. Every edge kept is the lightest edge
+// leaving a tree, hence belongs to the mst. Trees are finally joined with
+// the lightest edges between them, as in Kruskal's algorithm.
+//
+// Unlike BuildPrimMst, the result is the list of mst edges.
+inline std::vector<Edge> BuildParallelPrimMst(Graph &graph,
+                                              unsigned int num_threads) {
+  unsigned int num_v = graph.GetNumV();
+  std::vector<std::vector<Edge>> &adj_edge_vec = graph.GetAdjEdgeVec();
+  const unsigned int kNoTree = UINT_MAX;
+
+  // Tree that claimed each vertex
+  std::vector<std::atomic<unsigned int>> owner_vec(num_v);
+  for (auto &owner : owner_vec)
+    owner = kNoTree;
+
+  // Every vertex is a candidate seed
+  ConcurrentIndexMinPQ<double> seeds(num_v, 2 * num_threads);
+  for (unsigned int v = 0; v < num_v; v++) {
+    double lightest = INFINITY;
+    for (auto &adj_edge : adj_edge_vec[v])
+      lightest = std::min(lightest, adj_edge.GetWeight());
+    seeds.Push(lightest, v);
+  }
+
+  std::mutex mst_mutex;
+  std::vector<Edge> mst;
+
+  auto worker = [&]() {
+    // Scratch space of the current tree, sized by the vertices it touches
+    // rather than by the graph: lightest known edge to each vertex of its
+    // frontier, and heap of candidate edges where entries superseded by a
+    // lighter edge are left behind and skipped when popped
+    typedef std::tuple<EdgeKey, unsigned int, Edge *> Candidate;
+    std::unordered_map<unsigned int, EdgeKey> dist_map;
+    std::priority_queue<Candidate, std::vector<Candidate>,
+                        std::greater<Candidate>> frontier;
+    std::vector<Edge> tree_edges;
+
+    unsigned int seed;
+    double seed_key;
+    while (seeds.TryPopMin(seed, seed_key)) {
+      unsigned int expected = kNoTree;
+      if (!owner_vec[seed].compare_exchange_strong(expected, seed))
+        continue;
+
+      unsigned int root = seed;
+      while (true) {
+        // Relax edges from the newly claimed vertex
+        for (auto &adj_edge : adj_edge_vec[root]) {
+          unsigned int adj = (adj_edge.GetSrc() == root) ?
+                             adj_edge.GetDst() : adj_edge.GetSrc();
+          if (owner_vec[adj] == seed)
+            continue;
+          EdgeKey key(adj_edge);
+          auto itr = dist_map.find(adj);
+          if (itr != dist_map.end() && !(key < itr->second))
+            continue;
+          dist_map[adj] = key;
+          frontier.push(std::make_tuple(key, adj, &adj_edge));
+        }
+
+        // Skip vertices that joined the tree through a lighter edge
+        while (!frontier.empty() &&
+               owner_vec[std::get<1>(frontier.top())] == seed)
+          frontier.pop();
+
+        // Tree spans its whole connected component
+        if (frontier.empty())
+          break;
+
+        // Lightest edge leaving the tree
+        root = std::get<1>(frontier.top());
+        tree_edges.push_back(*std::get<2>(frontier.top()));
+        frontier.pop();
+
+        // Reached another tree: stop here
+        unsigned int expected = kNoTree;
+        if (!owner_vec[root].compare_exchange_strong(expected, seed))
+          break;
+      }
+
+      // Reset scratch space for the next tree
+      dist_map.clear();
+      std::priority_queue<Candidate, std::vector<Candidate>,
+                          std::greater<Candidate>>().swap(frontier);
+    }
+
+    std::lock_guard<std::mutex> lock(mst_mutex);
+    mst.insert(mst.end(), tree_edges.begin(), tree_edges.end());
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < num_threads; i++)
+    threads.push_back(std::thread(worker));
+  for (auto &thread : threads)
+    thread.join();
+
+  // Merge trees through the edges found so far (two trees may have picked
+  // the same edge between them)
+  UnionFind forest(num_v);
+  std::vector<Edge> forest_edges;
+  for (auto &edge : mst) {
+    if (forest.Union(edge.GetSrc(), edge.GetDst()))
+      forest_edges.push_back(edge);
+  }
+  mst.swap(forest_edges);
+
+  // Join remaining trees with the lightest edges between them
+  std::vector<std::pair<EdgeKey, Edge>> crossing_edges;
+  for (unsigned int v = 0; v < num_v; v++) {
+    for (auto &adj_edge : adj_edge_vec[v]) {
+      if (adj_edge.GetSrc() == v &&
+          forest.Find(adj_edge.GetSrc()) != forest.Find(adj_edge.GetDst()))
+        crossing_edges.push_back(std::make_pair(EdgeKey(adj_edge), adj_edge));
+    }
+  }
+  std::sort(crossing_edges.begin(), crossing_edges.end(),
+            [](const std::pair<EdgeKey, Edge> &a,
+               const std::pair<EdgeKey, Edge> &b) {
+              return a.first < b.first;
+            });
+  for (auto &crossing : crossing_edges) {
+    if (forest.Union(crossing.second.GetSrc(), crossing.second.GetDst()))
+      mst.push_back(crossing.second);
+  }
+
+  return mst;
+}
+
+// Extract the edges of the mst built by BuildPrimMst, which stores the best
+// edge to each vertex (roots keeping a placeholder edge that does not lead
+// to them)
+inline std::vector<Edge> MstEdgeList(std::vector<Edge> &best_edge_vec) {
+  std::vector<Edge> mst_edges;
+  for (unsigned int v = 0; v < best_edge_vec.size(); v++) {
+    Edge &edge = best_edge_vec[v];
+    if ((edge.GetSrc() == v) != (edge.GetDst() == v))
+      mst_edges.push_back(edge);
+  }
+  return mst_edges;
+}
+
+// One merge of the single-linkage dendrogram. Vertices are clusters 0 to
+// V - 1, and merge i creates cluster V + i out of clusters @left and @right.
+struct Merge {
+  unsigned int left;
+  unsigned int right;
+  // weight of the mst edge joining both clusters
+  double height;
+  // number of vertices of the new cluster
+  unsigned int size;
+};
+
+// Single-linkage clustering of a graph, derived from its mst
+struct Clustering {
+  // merges in increasing order of height
+  std::vector<Merge> dendrogram;
+  // number of clusters (more than asked if the graph has more components)
+  unsigned int num_clusters;
+  // cluster of each vertex, numbered by first vertex
+  std::vector<unsigned int> cluster_vec;
+  // weight of the lightest mst edge cut, INFINITY if none
+  double threshold;
+};
+
+// Build the single-linkage dendrogram from the edges of the mst of a graph
+// with @num_v vertices, and cut it into @num_clusters clusters by leaving
+// out its heaviest edges
+inline Clustering BuildClustering(unsigned int num_v,
+                                  std::vector<Edge> mst_edges,
+                                  unsigned int num_clusters) {
+  Clustering clustering;
+  clustering.threshold = INFINITY;
+
+  // Merge clusters in increasing order of edge weight
+  std::sort(mst_edges.begin(), mst_edges.end(), [](Edge &a, Edge &b) {
+    return EdgeKey(a) < EdgeKey(b);
+  });
+
+  // Dendrogram cluster of each set representative
+  UnionFind sets(num_v);
+  std::vector<unsigned int> node_vec(num_v);
+  std::vector<unsigned int> size_vec(num_v, 1);
+  for (unsigned int v = 0; v < num_v; v++)
+    node_vec[v] = v;
+
+  unsigned int cur_clusters = num_v;
+  for (unsigned int i = 0; i <= mst_edges.size(); i++) {
+    // Reached the requested number of clusters (or ran out of edges): take
+    // a snapshot of the assignment, the next edge being the first one cut
+    if (clustering.cluster_vec.empty() &&
+        (cur_clusters <= num_clusters || i == mst_edges.size())) {
+      clustering.num_clusters = cur_clusters;
+      if (i < mst_edges.size())
+        clustering.threshold = mst_edges[i].GetWeight();
+      std::vector<unsigned int> label_vec(num_v, UINT_MAX);
+      unsigned int num_labels = 0;
+      for (unsigned int v = 0; v < num_v; v++) {
+        unsigned int root = sets.Find(v);
+        if (label_vec[root] == UINT_MAX)
+          label_vec[root] = num_labels++;
+        clustering.cluster_vec.push_back(label_vec[root]);
+      }
+    }
+    if (i == mst_edges.size())
+      break;
+
+    unsigned int src = sets.Find(mst_edges[i].GetSrc());
+    unsigned int dst = sets.Find(mst_edges[i].GetDst());
+    if (!sets.Union(src, dst))
+      continue;
+    unsigned int root = sets.Find(src);
+    Merge merge = {node_vec[src], node_vec[dst], mst_edges[i].GetWeight(),
+                   size_vec[src] + size_vec[dst]};
+    clustering.dendrogram.push_back(merge);
+    node_vec[root] = num_v + clustering.dendrogram.size() - 1;
+    size_vec[root] = merge.size;
+    cur_clusters--;
+  }
+
+  return clustering;
+}
+
+#endif  // MST_H_
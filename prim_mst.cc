@@ -1,62 +1,20 @@
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <condition_variable>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <vector>
+#include <sstream>
 #include <string>
 #include <cmath>
 #include <iomanip>
+#include <thread>
 
-#include "index_min_pq.h"
-
-// Class of edge that stores source vertex, destination vertex, and
-// the weight of the edge
-class Edge {
- public:
-  // Constructor
-  Edge(unsigned int src, unsigned int dst, double weight)
-                                        : src(src), dst(dst), weight(weight) {}
-  unsigned int GetSrc() { return src; }
-  unsigned int GetDst() { return dst; }
-  double GetWeight() { return weight; }
- private:
-  unsigned int src;
-  unsigned int dst;
-  double weight;
-};
-
-// Class that represents graph. Adjacent_list implementation is used, but
-// instead of vector of vertex, we used vector of Edge for each vertex.
-class Graph {
- public:
-  // Constructor
-  explicit Graph(std::ifstream &input_file);
-  // number of vertices
-  unsigned int GetNumV() { return num_vertex; }
-  // Vector of Edges adjacent to vertex
-  std::vector<std::vector<Edge>> GetAdjEdgeVec() { return adj_edge_vec; }
- private:
-  unsigned int num_vertex;
-  // Adjacency lists implementation
-  std::vector<std::vector<Edge>> adj_edge_vec;
-};
-
-Graph::Graph(std::ifstream &input_file) {
-  // Get number of vertices
-  input_file >> num_vertex;
-
-  // Allocate list of vertces
-  adj_edge_vec.resize(num_vertex);
-
-  unsigned int cur_src;
-  unsigned int cur_dst;
-  double cur_weight;
-
-  // Go through all the edges
-  while (input_file >> cur_src >> cur_dst >> cur_weight) {
-    Edge cur_edge(cur_src, cur_dst, cur_weight);
-    adj_edge_vec[cur_src].push_back(cur_edge);
-    adj_edge_vec[cur_dst].push_back(cur_edge);
-  }
-}
+#include "mst.h"
 
 // Check if the string is Positive Integer
 bool IsPositiveInteger(std::string input) {
@@ -68,28 +26,31 @@ bool IsPositiveDouble(std::string input) {
   return (input.find_first_not_of(".0123456789") == std::string::npos);
 }
 
-// Check if the command line argument
-bool IsValidArgument(int argc, char* argv[]) {
-  // check if text file is given
-  if (argc < 2) {
-    std::cerr << "Usage: ./prim_mst <graph.dat>" << std::endl;
+// Check if the string is a count (strictly positive integer), store it in
+// @count
+bool ParseCount(std::string input, unsigned int &count) {
+  if (input.empty() || input.size() > 9 || !IsPositiveInteger(input))
     return false;
-  }
+  count = std::stoi(input);
+  return count > 0;
+}
 
-  // check if the file can be opened
-  std::ifstream input_file(argv[1]);
-  if (!static_cast<bool>(input_file)) {
-    std::cerr << "Error: cannot open file " << argv[1] << std::endl;
+// Check if the string is a vertex number of a graph of @graph_size vertices
+bool IsValidVertex(std::string input, int graph_size) {
+  if (input.empty() || input.size() > 9 || !IsPositiveInteger(input))
     return false;
-  }
+  return std::stoi(input) < graph_size;
+}
 
+// Check if the content of a graph file is valid, reporting problems to @err
+bool IsValidGraph(std::istream &input_file, std::ostream &err) {
   // Check if graph size is valid
   // 1) if the size exist
   // 2) if size is positive integer
   std::string temp;
   input_file >> temp;
-  if (!IsPositiveInteger(temp) || input_file.eof()) {
-    std::cerr << "Error: invalid graph size" << std::endl;
+  if (!IsPositiveInteger(temp) || temp.size() > 9 || input_file.eof()) {
+    err << "Error: invalid graph size" << std::endl;
     return false;
   }
 
@@ -100,22 +61,22 @@ bool IsValidArgument(int argc, char* argv[]) {
   while (input_file >> temp) {
     // check source
     if (counter % 3 == 0) {
-      if (!IsPositiveInteger(temp) || (std::stoi(temp) > graph_size)) {
-        std::cerr << "Invalid source vertex number " << temp << std::endl;
+      if (!IsValidVertex(temp, graph_size)) {
+        err << "Invalid source vertex number " << temp << std::endl;
         return false;
       }
     }
     // check dest
     if (counter % 3 == 1) {
-      if (!IsPositiveInteger(temp) || (std::stoi(temp) > graph_size)) {
-        std::cerr << "Invalid dest vertex number " << temp << std::endl;
+      if (!IsValidVertex(temp, graph_size)) {
+        err << "Invalid dest vertex number " << temp << std::endl;
         return false;
       }
     }
     // check weight
     if (counter % 3 == 2) {
       if (!IsPositiveDouble(temp)) {
-        std::cerr << "Invalid weight " << temp << std::endl;
+        err << "Invalid weight " << temp << std::endl;
         return false;
       }
     }
@@ -125,81 +86,45 @@ bool IsValidArgument(int argc, char* argv[]) {
   return true;
 }
 
-// Build prim mst from the graph
-std::vector<Edge> BuildPrimMst(Graph graph) {
-  // store graph's objects as local variables
-  unsigned int num_v = graph.GetNumV();
-  std::vector<std::vector<Edge>> adj_edge_vec = graph.GetAdjEdgeVec();
-
-  // create min-priority queue Q
-  IndexMinPQ<double> Q(num_v);
-  // Unknown distance from src to v
-  std::vector<double> dist_vec(num_v, INFINITY);
-  // Vertex v has not been visited
-  std::vector<bool> marked_vec(num_v, false);
-  // Best edge to v
-  // std::vector<int> best_edge_vec(num_v, -1);
-  std::vector<Edge> best_edge_vec(num_v, Edge(0, 0, 0));
-
-  // Go through each vertex in graph
-  for (unsigned int v = 0; v < num_v; v++) {
-    // Skip visited vertex
-    if (marked_vec[v]) {
-      continue;
-    }
+// Check if the command line argument
+bool IsValidArgument(int argc, char* argv[]) {
+  // check if text file is given
+  if (argc < 2) {
+    std::cerr << "Usage: ./prim_mst [--threads N]"
+              << " [--clusters K | --summary | --parents] <graph.dat>"
+              << std::endl;
+    std::cerr << "       ./prim_mst --batch <dir|manifest> [--jobs N]"
+              << " [--out-dir DIR]" << std::endl;
+    return false;
+  }
 
-    // Distance from v to itself is 0
-    dist_vec[v] = 0;
-
-    // Add first vertex to queue
-    Q.Push(dist_vec[v], v);
-
-    // iterate until min Q becomes empty
-    while (Q.Size()) {
-      // Remove and return closest vertex
-      unsigned int root = Q.Top();
-      Q.Pop();
-
-      // We have reached root
-      marked_vec[root] = true;
-
-      // Go through all the neighbors
-      for (auto &adj_edge : adj_edge_vec[root]) {
-        // vertex adjacent to root
-        unsigned int adj;
-
-        // find the adj vertex from the adj edge: (root - adj) or (adj - root)
-        if (adj_edge.GetDst() == root)
-          adj = adj_edge.GetSrc();
-        else if (adj_edge.GetSrc() == root)
-          adj = adj_edge.GetDst();
-
-        // Skip visited vertex
-        if (marked_vec[adj]) {
-          continue;
-        }
-
-        // New path to reach vertex is better than existing one
-        if (adj_edge.GetWeight() < dist_vec[adj]) {
-          dist_vec[adj] = adj_edge.GetWeight();         // Update distance to v
-          best_edge_vec[adj] = adj_edge;               // Update best edge to v
-
-          // Update priority queue
-          if (Q.Contains(adj))
-            Q.ChangeKey(dist_vec[adj], adj);
-          else
-            Q.Push(dist_vec[adj], adj);
-        }
-      }
-    }
+  // check if the file can be opened
+  std::ifstream input_file(argv[1]);
+  if (!static_cast<bool>(input_file)) {
+    std::cerr << "Error: cannot open file " << argv[1] << std::endl;
+    return false;
   }
 
-  // mst is complete in the form of vector of edges
-  return best_edge_vec;
+  return IsValidGraph(input_file, std::cerr);
 }
 
-// Print out the mst we have built
-void PrintMst(std::vector<Edge> mst) {
+// Print out the clustering to @out
+void PrintClustering(Clustering &clustering, std::ostream &out = std::cout) {
+  out << std::fixed << std::setprecision(5);
+  // print the cut threshold and cluster of each vertex
+  out << "threshold " << clustering.threshold << std::endl;
+  out << "clusters " << clustering.num_clusters << std::endl;
+  for (unsigned int v = 0; v < clustering.cluster_vec.size(); v++)
+    out << v << " " << clustering.cluster_vec[v] << std::endl;
+  // print the merges of the dendrogram
+  out << "dendrogram " << clustering.dendrogram.size() << std::endl;
+  for (auto &merge : clustering.dendrogram)
+    out << merge.left << " " << merge.right << " " << merge.height << " "
+        << merge.size << std::endl;
+}
+
+// Print out the mst we have built to @out
+void PrintMst(std::vector<Edge> &mst, std::ostream &out = std::cout) {
   // keep track of total weight of mst
   double total_weight = 0.0;
   // Go through mst (each Edge class)
@@ -207,22 +132,317 @@ void PrintMst(std::vector<Edge> mst) {
     // skip unworthy path
     if (itr.GetWeight() == 0) continue;
     // print source, destination, and weight in a proper manner
-    std::cout << std::right << std::setfill('0') << std::setw(4)
+    out << std::right << std::setfill('0') << std::setw(4)
                                                  << itr.GetSrc() << "-";
-    std::cout << std::right << std::setfill('0') << std::setw(4)
+    out << std::right << std::setfill('0') << std::setw(4)
                                                  << itr.GetDst();
-    std::cout << " (" << std::left << std::setfill('0')
+    out << " (" << std::left << std::setfill('0')
                       << std::setw(7) << itr.GetWeight() << ")" << std::endl;
     // add on to the total weight
     total_weight += itr.GetWeight();
   }
   // print the total weight of minimum spanning tree
-  std::cout << std::left << std::setfill('0') << std::setw(7)
+  out << std::left << std::setfill('0') << std::setw(7)
             << std::fixed << std::setprecision(5) <<  total_weight << std::endl;
 }
 
 
+// Print out the summary of an mst to @out
+void PrintSummary(MstSummary &summary, std::ostream &out = std::cout) {
+  out << "weight " << std::fixed << std::setprecision(5)
+      << summary.total_weight << std::endl;
+  out << "edges " << summary.num_edges << std::endl;
+  out << "hash " << std::hex << std::setfill('0') << std::setw(16)
+      << summary.hash << std::dec << std::endl;
+}
+
+// Print out the parent of each vertex to @out, one per line
+void PrintParents(std::vector<unsigned int> &parent_vec,
+                  std::ostream &out = std::cout) {
+  for (auto parent : parent_vec)
+    out << parent << "\n";
+  out.flush();
+}
+
+// One graph file of a batch, and the result of processing it
+struct BatchJob {
+  std::string path;
+  // rendered mst (ordered stream mode only)
+  std::string output;
+  // error message if the file could not be processed
+  std::string error;
+  bool done = false;
+};
+
+// Options of the batch mode
+struct BatchOptions {
+  // number of worker threads
+  unsigned int num_jobs = 1;
+  // write each mst to its own file in that directory instead of stdout
+  std::string out_dir;
+};
+
+// Check if @path is a directory
+bool IsDirectory(const std::string &path) {
+  struct stat info;
+  return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+// Collect the graph files of a batch: every .dat file of @path (sorted by
+// name) if it is a directory, otherwise every non-empty line of manifest @path
+bool CollectBatchFiles(const std::string &path,
+                       std::vector<std::string> &files) {
+  if (IsDirectory(path)) {
+    DIR *dir = opendir(path.c_str());
+    if (!dir) {
+      std::cerr << "Error: cannot open directory " << path << std::endl;
+      return false;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dat") == 0)
+        files.push_back(path + "/" + name);
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    return true;
+  }
+
+  std::ifstream manifest(path);
+  if (!static_cast<bool>(manifest)) {
+    std::cerr << "Error: cannot open file " << path << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(manifest, line)) {
+    if (!line.empty())
+      files.push_back(line);
+  }
+  return true;
+}
+
+// Name of the per-file output of graph file @path inside @out_dir
+std::string BatchOutputPath(const std::string &path,
+                            const std::string &out_dir) {
+  std::string name = path.substr(path.find_last_of('/') + 1);
+  if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dat") == 0)
+    name.resize(name.size() - 4);
+  return out_dir + "/" + name + ".mst";
+}
+
+// Read, check, solve and render one graph file of a batch
+void ProcessBatchJob(BatchJob &job, const BatchOptions &options,
+                     PrimWorkspace &workspace) {
+  // read the whole file at once, then parse it from memory
+  std::ifstream input_file(job.path);
+  if (!static_cast<bool>(input_file)) {
+    job.error = "Error: cannot open file " + job.path + "\n";
+    return;
+  }
+  std::stringstream content;
+  content << input_file.rdbuf();
+
+  std::ostringstream err;
+  if (!IsValidGraph(content, err)) {
+    job.error = err.str();
+    return;
+  }
+  content.clear();
+  content.seekg(0);
+
+  Graph graph(content);
+  std::vector<Edge> mst = BuildPrimMst(graph, workspace);
+
+  std::ostringstream out;
+  PrintMst(mst, out);
+  if (options.out_dir.empty()) {
+    job.output = out.str();
+    return;
+  }
+  std::string out_path = BatchOutputPath(job.path, options.out_dir);
+  std::ofstream out_file(out_path);
+  if (!(out_file << out.str()))
+    job.error = "Error: cannot write file " + out_path + "\n";
+}
+
+// Compute the mst of every file of @files with a pool of worker threads.
+// Workers take files in order from a shared cursor, each with its own
+// workspace, while the calling thread emits the results in the same order.
+// Return false if any file failed.
+bool RunBatch(const std::vector<std::string> &files,
+              const BatchOptions &options) {
+  std::vector<BatchJob> jobs(files.size());
+  for (size_t i = 0; i < files.size(); i++)
+    jobs[i].path = files[i];
+
+  // Workers do not run further ahead of the output than this many files,
+  // which bounds the memory held by rendered msts waiting to be written
+  const size_t window = 4 * options.num_jobs;
+
+  std::mutex mutex;
+  std::condition_variable cond_done;
+  std::condition_variable cond_written;
+  size_t next_job = 0;
+  size_t num_written = 0;
+
+  auto worker = [&]() {
+    PrimWorkspace workspace;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cond_written.wait(lock, [&]() {
+        return next_job >= jobs.size() || next_job < num_written + window;
+      });
+      if (next_job >= jobs.size())
+        break;
+      BatchJob &job = jobs[next_job++];
+
+      lock.unlock();
+      // A bad file must not bring the whole batch down
+      try {
+        ProcessBatchJob(job, options, workspace);
+      } catch (std::exception &e) {
+        job.error = std::string("Error: ") + e.what() + "\n";
+        // the queue may have been left non-empty
+        workspace = PrimWorkspace();
+      }
+      lock.lock();
+
+      job.done = true;
+      cond_done.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < options.num_jobs; i++)
+    threads.push_back(std::thread(worker));
+
+  // Emit results in input order as soon as they are available
+  bool success = true;
+  for (size_t i = 0; i < jobs.size(); i++) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond_done.wait(lock, [&]() { return jobs[i].done; });
+    }
+    if (!jobs[i].error.empty()) {
+      std::cerr << jobs[i].path << ": " << jobs[i].error;
+      success = false;
+    } else if (options.out_dir.empty()) {
+      std::cout << "# " << jobs[i].path << "\n" << jobs[i].output;
+    }
+    std::string().swap(jobs[i].output);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      num_written++;
+    }
+    cond_written.notify_all();
+  }
+  std::cout.flush();
+
+  for (auto &thread : threads)
+    thread.join();
+  return success;
+}
+
+// Parse the command line of the batch mode and run it
+int BatchMain(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: ./prim_mst --batch <dir|manifest> [--jobs N]"
+              << " [--out-dir DIR]" << std::endl;
+    return 1;
+  }
+
+  BatchOptions options;
+  options.num_jobs = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 3; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--jobs" && i + 1 < argc) {
+      std::string value = argv[++i];
+      if (!ParseCount(value, options.num_jobs)) {
+        std::cerr << "Error: invalid number of jobs " << value << std::endl;
+        return 1;
+      }
+    } else if (arg == "--out-dir" && i + 1 < argc) {
+      options.out_dir = argv[++i];
+      if (!IsDirectory(options.out_dir)) {
+        std::cerr << "Error: cannot open directory " << options.out_dir
+                  << std::endl;
+        return 1;
+      }
+    } else {
+      std::cerr << "Error: unknown option " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<std::string> files;
+  if (!CollectBatchFiles(argv[2], files))
+    return 1;
+
+  // Files of a manifest may come from several directories, and must not
+  // write to the same output
+  if (!options.out_dir.empty()) {
+    std::map<std::string, std::string> out_paths;
+    for (auto &file : files) {
+      std::string out_path = BatchOutputPath(file, options.out_dir);
+      if (out_paths.count(out_path)) {
+        std::cerr << "Error: " << out_paths[out_path] << " and " << file
+                  << " would both be written to " << out_path << std::endl;
+        return 1;
+      }
+      out_paths[out_path] = file;
+    }
+  }
+
+  return RunBatch(files, options) ? 0 : 1;
+}
+
+
 int main(int argc, char* argv[]) {
+  // compute the msts of many graph files
+  if (argc >= 2 && std::string(argv[1]) == "--batch")
+    return BatchMain(argc, argv);
+
+  // Options before the graph file:
+  // --threads N: grow several trees at once with that many threads
+  // --clusters K: print the single-linkage clustering into K clusters
+  // --summary: print only total weight, number of edges and hash of the mst
+  // --parents: print only the parent of each vertex in the mst
+  unsigned int num_threads = 0;
+  unsigned int num_clusters = 0;
+  bool summary_mode = false;
+  bool parents_mode = false;
+  while (argc >= 2 && std::string(argv[1]).compare(0, 2, "--") == 0) {
+    std::string arg = argv[1];
+    if (arg == "--summary" || arg == "--parents") {
+      (arg == "--summary" ? summary_mode : parents_mode) = true;
+      argc -= 1;
+      argv += 1;
+      continue;
+    }
+    std::string value = (argc >= 3) ? argv[2] : "";
+    if (arg == "--threads" && !ParseCount(value, num_threads)) {
+      std::cerr << "Error: invalid number of threads " << value << std::endl;
+      exit(1);
+    } else if (arg == "--clusters" && !ParseCount(value, num_clusters)) {
+      std::cerr << "Error: invalid number of clusters " << value << std::endl;
+      exit(1);
+    } else if (arg != "--threads" && arg != "--clusters") {
+      std::cerr << "Error: unknown option " << arg << std::endl;
+      exit(1);
+    }
+    argc -= 2;
+    argv += 2;
+  }
+  if ((num_clusters > 0) + summary_mode + parents_mode > 1) {
+    std::cerr << "Error: --clusters, --summary and --parents are exclusive"
+              << std::endl;
+    exit(1);
+  }
+  if (parents_mode && num_threads) {
+    std::cerr << "Error: --parents does not support --threads" << std::endl;
+    exit(1);
+  }
+
   // checks if command line arguments are valid
   if (!IsValidArgument(argc, argv)) exit(1);
 
@@ -232,9 +452,36 @@ int main(int argc, char* argv[]) {
   // construct graph from the input file
   Graph graph(input_file);
 
-  // Build and display the minimum spanning tree of graph
-  std::vector<Edge> mst = BuildPrimMst(graph);
-  PrintMst(mst);
+  // Compact modes never build the full list of edges
+  PrimWorkspace workspace;
+  if (summary_mode && !num_threads) {
+    MstSummary summary = BuildPrimSummary(graph, workspace);
+    PrintSummary(summary);
+    return 0;
+  }
+  if (parents_mode) {
+    std::vector<unsigned int> parent_vec = BuildPrimParents(graph, workspace);
+    PrintParents(parent_vec);
+    return 0;
+  }
+
+  // Build the minimum spanning tree of graph
+  std::vector<Edge> mst = num_threads ? BuildParallelPrimMst(graph, num_threads)
+                                      : BuildPrimMst(graph, workspace);
+
+  // Display either the summary, the clustering or the tree itself
+  if (summary_mode) {
+    MstSummary summary;
+    for (auto &edge : mst)
+      summary.Add(edge);
+    PrintSummary(summary);
+  } else if (num_clusters) {
+    Clustering clustering = BuildClustering(
+        graph.GetNumV(), num_threads ? mst : MstEdgeList(mst), num_clusters);
+    PrintClustering(clustering);
+  } else {
+    PrintMst(mst);
+  }
 
   return 0;
 }
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrent_index_min_pq.h"
+
+// Check that a single internal queue behaves as an exact priority queue
+TEST(ConcurrentIndexMinPQ, SingleQueueOrder) {
+  // Concurrent indexed min-priority queue of capacity 100, one queue
+  ConcurrentIndexMinPQ<double> impq(100, 1);
+
+  // Insert key-values
+  std::vector<std::pair<double, int>> keyval{
+    { 6.0, 60},
+    { 2.0, 20},
+    { 8.0, 80},
+    { 4.0, 40}
+  };
+  for (auto &i : keyval)
+    impq.Push(i.first, i.second);
+  EXPECT_EQ(impq.Size(), 4);
+
+  unsigned int idx;
+  double key;
+  EXPECT_TRUE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(idx, 20);
+  EXPECT_EQ(key, 2.0);
+  EXPECT_TRUE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(idx, 40);
+  EXPECT_TRUE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(idx, 60);
+  EXPECT_TRUE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(idx, 80);
+  EXPECT_FALSE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(impq.Size(), 0);
+}
+
+// Check DecreaseKey only ever lowers keys of present indexes
+TEST(ConcurrentIndexMinPQ, DecreaseKey) {
+  // Concurrent indexed min-priority queue of capacity 100, one queue
+  ConcurrentIndexMinPQ<double> impq(100, 1);
+
+  impq.Push(5.0, 99);
+  impq.Push(25.0, 77);
+
+  EXPECT_FALSE(impq.DecreaseKey(1.0, 33));
+  EXPECT_FALSE(impq.DecreaseKey(30.0, 77));
+  EXPECT_TRUE(impq.DecreaseKey(1.0, 77));
+
+  unsigned int idx;
+  double key;
+  EXPECT_TRUE(impq.TryPopMin(idx, key));
+  EXPECT_EQ(idx, 77);
+  EXPECT_EQ(key, 1.0);
+}
+
+// Check that every index is popped exactly once by concurrent threads
+TEST(ConcurrentIndexMinPQ, ConcurrentDrain) {
+  const unsigned int num_items = 10000;
+  const unsigned int num_threads = 4;
+  ConcurrentIndexMinPQ<double> impq(num_items, 2 * num_threads);
+
+  std::vector<std::vector<unsigned int>> popped(num_threads);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < num_threads; t++) {
+    threads.push_back(std::thread([&, t]() {
+      for (unsigned int idx = t; idx < num_items; idx += num_threads)
+        impq.Push(num_items - idx, idx);
+      unsigned int idx;
+      double key;
+      while (impq.TryPopMin(idx, key))
+        popped[t].push_back(idx);
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<unsigned int> all;
+  for (auto &p : popped)
+    all.insert(all.end(), p.begin(), p.end());
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(all.size(), num_items);
+  for (unsigned int idx = 0; idx < num_items; idx++)
+    EXPECT_EQ(all[idx], idx);
+}
+
+// Check Exception for Push
+TEST(ConcurrentIndexMinPQ, PushException) {
+  // Concurrent indexed min-priority queue of capacity 4, two queues
+  ConcurrentIndexMinPQ<char> impq(4, 2);
+
+  impq.Push('B', 2);
+  // runtime_error (duplicate index)
+  EXPECT_THROW(impq.Push('H', 2), std::exception);
+  // overflow_error
+  EXPECT_THROW(impq.Push('F', 4), std::exception);
+}
+
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -310,6 +310,65 @@ TEST(IndexMinPQ, ChangeKeyException) {
 }
 
 
+// Check ChangeKey on an item moved to the root by Pop without percolating
+TEST(IndexMinPQ, ChangeKeyAfterPop) {
+  // Indexed min-priority queue of capacity 100
+  IndexMinPQ<double> impq(100);
+
+  // Insert key-values
+  std::vector<std::pair<double, int>> keyval{
+    { 1.0, 10},
+    { 2.0, 20},
+    { 2.0, 30},
+    { 2.0, 40}
+  };
+  for (auto &i : keyval)
+    impq.Push(i.first, i.second);
+  // 40 moves to the root and stays there (same key as its children)
+  impq.Pop();
+  EXPECT_EQ(impq.Top(), 40);
+  // 50 takes the former place of 40
+  impq.Push(3.0, 50);
+
+  impq.ChangeKey(9.0, 40);
+  EXPECT_NE(impq.Top(), 40);
+  impq.Pop();
+  impq.Pop();
+  // Key-value at the top should now be (3.0, 50), then (9.0, 40)
+  EXPECT_EQ(impq.Top(), 50);
+  impq.Pop();
+  EXPECT_EQ(impq.Top(), 40);
+  impq.Pop();
+  EXPECT_FALSE(impq.Contains(40));
+}
+
+// Check Resize to reuse an emptied queue with another capacity
+TEST(IndexMinPQ, Resize) {
+  // Indexed min-priority queue of capacity 4
+  IndexMinPQ<double> impq(4);
+
+  impq.Push(3.0, 3);
+  // runtime_error (queue not empty)
+  EXPECT_THROW(impq.Resize(10), std::exception);
+  impq.Pop();
+
+  // Grow the queue, previous indexes are not valid anymore
+  impq.Resize(10);
+  EXPECT_FALSE(impq.Contains(3));
+  impq.Push(9.0, 9);
+  impq.Push(1.0, 1);
+  EXPECT_EQ(impq.Top(), 1);
+  impq.Pop();
+  impq.Pop();
+
+  // Shrink the queue
+  impq.Resize(2);
+  // overflow_error
+  EXPECT_THROW(impq.Push(5.0, 5), std::exception);
+  impq.Push(5.0, 1);
+  EXPECT_EQ(impq.Top(), 1);
+}
+
 int main(int argc, char *argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mst.h"
+
+// Build a graph from its description in the graph file format
+Graph MakeGraph(const std::string &content) {
+  std::istringstream input(content);
+  return Graph(input);
+}
+
+// Edges of an mst as sorted (lo, hi, weight) tuples, to compare msts
+// regardless of edge order and orientation
+std::vector<std::tuple<unsigned int, unsigned int, double>> SortedEdges(
+    std::vector<Edge> &mst) {
+  std::vector<std::tuple<unsigned int, unsigned int, double>> edges;
+  for (auto &edge : mst) {
+    EdgeKey key(edge);
+    edges.push_back(std::make_tuple(key.lo, key.hi, key.weight));
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+// Check parallel prim on a small graph with a known mst
+TEST(BuildParallelPrimMst, SmallGraph) {
+  Graph graph = MakeGraph("5\n"
+                          "0 1 4.0\n"
+                          "0 2 1.0\n"
+                          "1 2 2.0\n"
+                          "1 3 5.0\n"
+                          "2 3 8.0\n"
+                          "3 4 3.0\n"
+                          "2 4 9.0\n");
+  std::vector<std::tuple<unsigned int, unsigned int, double>> expected{
+    std::make_tuple(0, 2, 1.0),
+    std::make_tuple(1, 2, 2.0),
+    std::make_tuple(1, 3, 5.0),
+    std::make_tuple(3, 4, 3.0)
+  };
+  std::sort(expected.begin(), expected.end());
+
+  for (unsigned int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::vector<Edge> mst = BuildParallelPrimMst(graph, num_threads);
+    EXPECT_EQ(SortedEdges(mst), expected);
+  }
+}
+
+// Check parallel prim on a disconnected graph with self-loops and parallel
+// edges: it builds a spanning forest
+TEST(BuildParallelPrimMst, DisconnectedGraph) {
+  Graph graph = MakeGraph("6\n"
+                          "0 1 2.0\n"
+                          "0 1 1.0\n"
+                          "1 1 0.5\n"
+                          "3 4 7.0\n"
+                          "4 5 6.0\n"
+                          "3 5 5.0\n");
+  std::vector<std::tuple<unsigned int, unsigned int, double>> expected{
+    std::make_tuple(0, 1, 1.0),
+    std::make_tuple(3, 5, 5.0),
+    std::make_tuple(4, 5, 6.0)
+  };
+
+  for (unsigned int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::vector<Edge> mst = BuildParallelPrimMst(graph, num_threads);
+    EXPECT_EQ(SortedEdges(mst), expected);
+  }
+}
+
+// Check parallel prim finds the same (unique) mst as sequential prim on a
+// random graph with distinct weights
+TEST(BuildParallelPrimMst, MatchesSequential) {
+  const unsigned int num_v = 2000;
+  std::mt19937 gen(42);
+  std::vector<unsigned int> weight_vec(4 * num_v);
+  for (unsigned int i = 0; i < weight_vec.size(); i++)
+    weight_vec[i] = i + 1;
+  std::shuffle(weight_vec.begin(), weight_vec.end(), gen);
+
+  std::ostringstream content;
+  content << num_v << "\n";
+  for (auto weight : weight_vec)
+    content << gen() % num_v << " " << gen() % num_v << " " << weight << "\n";
+  Graph graph = MakeGraph(content.str());
+
+  std::vector<Edge> best_edge_vec = BuildPrimMst(graph);
+  std::vector<Edge> expected;
+  for (unsigned int v = 0; v < num_v; v++) {
+    Edge &edge = best_edge_vec[v];
+    if ((edge.GetSrc() == v) != (edge.GetDst() == v))
+      expected.push_back(edge);
+  }
+
+  for (unsigned int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::vector<Edge> mst = BuildParallelPrimMst(graph, num_threads);
+    EXPECT_EQ(SortedEdges(mst), SortedEdges(expected));
+  }
+}
+
+// Check MstEdgeList keeps the edges of BuildPrimMst, not the placeholders
+// of tree roots
+TEST(MstEdgeList, PrimResult) {
+  Graph graph = MakeGraph("5\n"
+                          "1 0 1.0\n"
+                          "1 2 5.0\n"
+                          "3 4 2.0\n");
+  std::vector<Edge> best_edge_vec = BuildPrimMst(graph);
+  std::vector<Edge> mst = MstEdgeList(best_edge_vec);
+  std::vector<std::tuple<unsigned int, unsigned int, double>> expected{
+    std::make_tuple(0, 1, 1.0),
+    std::make_tuple(1, 2, 5.0),
+    std::make_tuple(3, 4, 2.0)
+  };
+  EXPECT_EQ(SortedEdges(mst), expected);
+}
+
+// Check clustering of the path 0-1 (1), 1-2 (5), 2-3 (2) into 2 clusters
+TEST(BuildClustering, PathTwoClusters) {
+  std::vector<Edge> mst{Edge(0, 1, 1.0), Edge(1, 2, 5.0), Edge(2, 3, 2.0)};
+  Clustering clustering = BuildClustering(4, mst, 2);
+
+  EXPECT_EQ(clustering.num_clusters, 2);
+  EXPECT_EQ(clustering.threshold, 5.0);
+  std::vector<unsigned int> expected_clusters{0, 0, 1, 1};
+  EXPECT_EQ(clustering.cluster_vec, expected_clusters);
+
+  // Merges create clusters 4, 5 and 6, in increasing order of height
+  ASSERT_EQ(clustering.dendrogram.size(), 3);
+  EXPECT_EQ(clustering.dendrogram[0].left, 0);
+  EXPECT_EQ(clustering.dendrogram[0].right, 1);
+  EXPECT_EQ(clustering.dendrogram[0].height, 1.0);
+  EXPECT_EQ(clustering.dendrogram[0].size, 2);
+  EXPECT_EQ(clustering.dendrogram[1].left, 2);
+  EXPECT_EQ(clustering.dendrogram[1].right, 3);
+  EXPECT_EQ(clustering.dendrogram[1].height, 2.0);
+  EXPECT_EQ(clustering.dendrogram[1].size, 2);
+  EXPECT_EQ(clustering.dendrogram[2].left, 4);
+  EXPECT_EQ(clustering.dendrogram[2].right, 5);
+  EXPECT_EQ(clustering.dendrogram[2].height, 5.0);
+  EXPECT_EQ(clustering.dendrogram[2].size, 4);
+}
+
+// Check clustering of a graph with more components than clusters asked:
+// every component is a cluster and no edge is cut
+TEST(BuildClustering, MoreComponentsThanClusters) {
+  std::vector<Edge> mst{Edge(0, 1, 1.0), Edge(3, 4, 2.0)};
+  Clustering clustering = BuildClustering(5, mst, 1);
+
+  EXPECT_EQ(clustering.num_clusters, 3);
+  EXPECT_EQ(clustering.threshold, INFINITY);
+  std::vector<unsigned int> expected_clusters{0, 0, 1, 2, 2};
+  EXPECT_EQ(clustering.cluster_vec, expected_clusters);
+  ASSERT_EQ(clustering.dendrogram.size(), 2);
+  EXPECT_EQ(clustering.dendrogram[1].left, 3);
+  EXPECT_EQ(clustering.dendrogram[1].right, 4);
+}
+
+// Check clustering into at least as many clusters as vertices: every
+// vertex is alone and the lightest edge is cut
+TEST(BuildClustering, AsManyClustersAsVertices) {
+  std::vector<Edge> mst{Edge(0, 1, 1.0), Edge(1, 2, 5.0), Edge(2, 3, 2.0)};
+  for (unsigned int num_clusters = 4; num_clusters <= 10; num_clusters += 6) {
+    Clustering clustering = BuildClustering(4, mst, num_clusters);
+
+    EXPECT_EQ(clustering.num_clusters, 4);
+    EXPECT_EQ(clustering.threshold, 1.0);
+    std::vector<unsigned int> expected_clusters{0, 1, 2, 3};
+    EXPECT_EQ(clustering.cluster_vec, expected_clusters);
+    EXPECT_EQ(clustering.dendrogram.size(), 3);
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}